@@ -1,5 +1,6 @@
 #include <sstream>
 
+#include "src/Expression.h"
 #include "src/FixedPoint.h"
 #include "src/FloatingPoint.h"
 
@@ -8,6 +9,15 @@ int main(int argc, char** argv) {
     std::cerr << "Invalid Argument";
     return -1;
   }
+  // lab1 -e f 1 "(a * b + c) / d" [d]
+  if (strcmp(argv[1], "-e") == 0) {
+    Expression opt;
+    if (!opt.Parse(argc - 1, argv + 1) || !opt.DoOperation()) {
+      std::cerr << "Invalid Argument";
+      return -1;
+    }
+    return 0;
+  }
   if (strlen(argv[1]) == 1) {
     FloatingPointArithmetic opt;
     if (!opt.Parse(argc, argv)) {
@@ -0,0 +1,217 @@
+#include "DecimalNumber.h"
+
+// 5^i and 2^k / 5^i are kept as 61 and 59 bit approximations, enough for
+// 24 bit mantissas (single) and therefore for 11 bit ones (half) too.
+static constexpr int32_t kPow5Bitcount = 61;
+static constexpr int32_t kPow5InvBitcount = 59;
+static constexpr int32_t kPow5Size = 47;
+static constexpr int32_t kPow5InvSize = 31;
+
+// ceil(log2(5^e)), 1 for e == 0
+static constexpr int32_t Pow5Bits(const int32_t e) {
+  return (int32_t)(((uint32_t)e * 1217359) >> 19) + 1;
+}
+
+// floor(log10(2^e))
+static constexpr uint32_t Log10Pow2(const int32_t e) {
+  return ((uint32_t)e * 78913) >> 18;
+}
+
+// floor(log10(5^e))
+static constexpr uint32_t Log10Pow5(const int32_t e) {
+  return ((uint32_t)e * 732923) >> 20;
+}
+
+struct Pow5Tables {
+  uint64_t pow5[kPow5Size] = {};
+  uint64_t pow5_inv[kPow5InvSize] = {};
+
+  constexpr Pow5Tables() {
+    unsigned __int128 power = 1;
+    for (int32_t i = 0; i < kPow5Size; ++i) {
+      int32_t bits = Pow5Bits(i);
+      if (bits <= kPow5Bitcount) {
+        pow5[i] = (uint64_t)(power << (kPow5Bitcount - bits));
+      } else {
+        pow5[i] = (uint64_t)(power >> (bits - kPow5Bitcount));
+      }
+      if (i < kPow5InvSize) {
+        int32_t shift = bits - 1 + kPow5InvBitcount;
+        // 5^i is odd, so floor(2^128 / 5^i) == floor((2^128 - 1) / 5^i)
+        unsigned __int128 numerator = (shift == 128)
+                                          ? ~(unsigned __int128)0
+                                          : (unsigned __int128)1 << shift;
+        pow5_inv[i] = (uint64_t)(numerator / power) + 1;
+      }
+      power *= 5;
+    }
+  }
+};
+
+static constexpr Pow5Tables kTables;
+
+static uint32_t MulShift(const uint64_t m, const uint64_t factor,
+                         const int32_t shift) {
+  return (uint32_t)(((unsigned __int128)m * factor) >> shift);
+}
+
+static uint32_t Pow5Factor(uint64_t value) {
+  uint32_t count = 0;
+  while (value % 5 == 0) {
+    value /= 5;
+    ++count;
+  }
+  return count;
+}
+
+static bool IsMultipleOfPow5(const uint64_t value, const uint32_t p) {
+  return Pow5Factor(value) >= p;
+}
+
+static bool IsMultipleOfPow2(const uint64_t value, const uint32_t p) {
+  return (value & (((uint64_t)1 << p) - 1)) == 0;
+}
+
+DecimalNumber::DecimalNumber(uint32_t ieee_mantissa, uint32_t ieee_exponent,
+                             const int32_t mantissa_size,
+                             const int32_t exponent_shift) {
+  // number = m2 * 2^e2, two extra bits to hold the interval bounds
+  int32_t e2;
+  uint64_t m2;
+  if (ieee_exponent == 0) {
+    e2 = 1 - exponent_shift - mantissa_size - 2;
+    m2 = ieee_mantissa;
+  } else {
+    e2 = ieee_exponent - exponent_shift - mantissa_size - 2;
+    m2 = ((uint64_t)1 << mantissa_size) | ieee_mantissa;
+  }
+  const bool accept_bounds = m2 % 2 == 0;
+
+  // [mm, mp] is the interval of numbers rounded to the encoding,
+  // it is twice as narrow below powers of two
+  uint64_t mv = 4 * m2;
+  uint64_t mp = 4 * m2 + 2;
+  uint32_t mm_shift = (ieee_mantissa != 0 || ieee_exponent <= 1);
+  uint64_t mm = 4 * m2 - 1 - mm_shift;
+
+  uint32_t vr, vp, vm;
+  int32_t e10;
+  bool vm_is_trailing_zeros = false;
+  bool vr_is_trailing_zeros = false;
+  uint32_t last_removed_digit = 0;
+  if (e2 >= 0) {
+    uint32_t q = Log10Pow2(e2);
+    e10 = q;
+    int32_t k = kPow5InvBitcount + Pow5Bits(q) - 1;
+    int32_t i = -e2 + (int32_t)q + k;
+    vr = MulShift(mv, kTables.pow5_inv[q], i);
+    vp = MulShift(mp, kTables.pow5_inv[q], i);
+    vm = MulShift(mm, kTables.pow5_inv[q], i);
+    if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+      int32_t l = kPow5InvBitcount + Pow5Bits(q - 1) - 1;
+      last_removed_digit =
+          MulShift(mv, kTables.pow5_inv[q - 1], -e2 + (int32_t)q - 1 + l) %
+          10;
+    }
+    if (q <= 9) {
+      // only one of mm, mv and mp can be a multiple of 5
+      if (mv % 5 == 0) {
+        vr_is_trailing_zeros = IsMultipleOfPow5(mv, q);
+      } else if (accept_bounds) {
+        vm_is_trailing_zeros = IsMultipleOfPow5(mm, q);
+      } else {
+        vp -= IsMultipleOfPow5(mp, q);
+      }
+    }
+  } else {
+    uint32_t q = Log10Pow5(-e2);
+    e10 = (int32_t)q + e2;
+    int32_t i = -e2 - (int32_t)q;
+    int32_t k = Pow5Bits(i) - kPow5Bitcount;
+    int32_t j = (int32_t)q - k;
+    vr = MulShift(mv, kTables.pow5[i], j);
+    vp = MulShift(mp, kTables.pow5[i], j);
+    vm = MulShift(mm, kTables.pow5[i], j);
+    if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+      j = (int32_t)q - 1 - (Pow5Bits(i + 1) - kPow5Bitcount);
+      last_removed_digit = MulShift(mv, kTables.pow5[i + 1], j) % 10;
+    }
+    if (q <= 1) {
+      // mv = 4 * m2 has at least two trailing zero bits,
+      // mm has one iff mm_shift is set, mp always has one
+      vr_is_trailing_zeros = true;
+      if (accept_bounds) {
+        vm_is_trailing_zeros = mm_shift == 1;
+      } else {
+        --vp;
+      }
+    } else if (q < 31) {
+      vr_is_trailing_zeros = IsMultipleOfPow2(mv, q - 1);
+    }
+  }
+
+  // remove digits while both bounds still differ, the common case
+  // (no exact trailing zeros) needs only the last removed digit
+  int32_t removed = 0;
+  if (vm_is_trailing_zeros || vr_is_trailing_zeros) {
+    while (vp / 10 > vm / 10) {
+      vm_is_trailing_zeros &= vm % 10 == 0;
+      vr_is_trailing_zeros &= last_removed_digit == 0;
+      last_removed_digit = vr % 10;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+    if (vm_is_trailing_zeros) {
+      while (vm % 10 == 0) {
+        vr_is_trailing_zeros &= last_removed_digit == 0;
+        last_removed_digit = vr % 10;
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        ++removed;
+      }
+    }
+    if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0) {
+      last_removed_digit = 4;
+    }
+    digits = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) ||
+                   last_removed_digit >= 5);
+  } else {
+    while (vp / 10 > vm / 10) {
+      last_removed_digit = vr % 10;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+    digits = vr + (vr == vm || last_removed_digit >= 5);
+  }
+  exponent = e10 + removed;
+}
+
+DecimalNumber::DecimalNumber() = default;
+
+void DecimalNumber::PrintNumber() const {
+  char buffer[10];
+  int32_t length = 0;
+  uint32_t number = digits;
+  do {
+    buffer[length++] = '0' + number % 10;
+    number /= 10;
+  } while (number > 0);
+  std::cout << buffer[length - 1];
+  if (length > 1) {
+    std::cout << '.';
+    for (int32_t i = length - 2; i >= 0; --i) {
+      std::cout << buffer[i];
+    }
+  }
+  int32_t scientific_exponent = exponent + length - 1;
+  std::cout << 'e';
+  if (scientific_exponent >= 0) {
+    std::cout << '+';
+  }
+  std::cout << scientific_exponent;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+
+// Shortest decimal digits * 10^exponent which is rounded back (to nearest,
+// ties to even) to the same binary encoding. Digits are generated with the
+// Ryu algorithm (Ulf Adams, 2018) using tables of powers of five instead of
+// big number arithmetic.
+struct DecimalNumber {
+  uint32_t digits = 0;
+  int32_t exponent = 0;
+
+  DecimalNumber(uint32_t ieee_mantissa, uint32_t ieee_exponent,
+                const int32_t mantissa_size, const int32_t exponent_shift);
+
+  DecimalNumber();
+
+  void PrintNumber() const;
+};
@@ -0,0 +1,216 @@
+#include "Expression.h"
+
+#include "HexNumber.h"
+
+Expression::Expression(const uint8_t format, const uint8_t rounding_type)
+    : format(format),
+      rounding_type(rounding_type),
+      arithmetic(format, rounding_type) {}
+
+Expression::Expression() = default;
+
+void Expression::SkipSpaces() {
+  while (*text == ' ') {
+    ++text;
+  }
+}
+
+void Expression::AddInstruction(const uint8_t operation,
+                                const uint32_t index) {
+  instructions.push_back({operation, index});
+  if (operation == 'v' || operation == 'c') {
+    ++depth;
+    if (depth > stack.size()) {
+      stack.resize(depth);
+    }
+  } else if (operation != 'n') {
+    --depth;
+  }
+}
+
+bool Expression::ParseSum() {
+  if (!ParseProduct()) {
+    return false;
+  }
+  SkipSpaces();
+  while (*text == '+' || *text == '-') {
+    uint8_t operation = *text;
+    ++text;
+    if (!ParseProduct()) {
+      return false;
+    }
+    AddInstruction(operation, 0);
+    SkipSpaces();
+  }
+  return true;
+}
+
+bool Expression::ParseProduct() {
+  if (!ParseFactor()) {
+    return false;
+  }
+  SkipSpaces();
+  while (*text == '*' || *text == '/') {
+    uint8_t operation = *text;
+    ++text;
+    if (!ParseFactor()) {
+      return false;
+    }
+    AddInstruction(operation, 0);
+    SkipSpaces();
+  }
+  return true;
+}
+
+bool Expression::ParseFactor() {
+  SkipSpaces();
+  if (*text == '-') {
+    ++text;
+    if (!ParseFactor()) {
+      return false;
+    }
+    AddInstruction('n', 0);
+    return true;
+  }
+  if (*text == '(') {
+    ++text;
+    if (!ParseSum()) {
+      return false;
+    }
+    SkipSpaces();
+    if (*text != ')') {
+      return false;
+    }
+    ++text;
+    return true;
+  }
+  if (*text >= 'a' && *text <= 'z') {
+    uint32_t index = *text - 'a';
+    ++text;
+    if (index + 1 > variables_count) {
+      variables_count = index + 1;
+    }
+    AddInstruction('v', index);
+    return true;
+  }
+  uint64_t number = 0;
+  if (!ReadHex(text, number)) {
+    return false;
+  }
+  if (format == 'h') {
+    number = (uint16_t)number;
+  }
+  AddInstruction('c', constants.size());
+  constants.push_back(FloatingNumber(number, format, rounding_type));
+  return true;
+}
+
+bool Expression::Compile(const char *expression) {
+  instructions.clear();
+  constants.clear();
+  stack.clear();
+  variables_count = 0;
+  depth = 0;
+  text = expression;
+  if (!ParseSum()) {
+    return false;
+  }
+  SkipSpaces();
+  if (*text != '\0') {
+    return false;
+  }
+  variables.resize(variables_count);
+  return true;
+}
+
+uint32_t Expression::GetVariablesCount() const { return variables_count; }
+
+FloatingNumber Expression::Evaluate(const FloatingNumber *operands) {
+  size_t top = 0;
+  for (const Instruction &instruction : instructions) {
+    switch (instruction.operation) {
+      case 'v':
+        stack[top++] = operands[instruction.index];
+        break;
+      case 'c':
+        stack[top++] = constants[instruction.index];
+        break;
+      case 'n':
+        stack[top - 1].ChangeSign(!stack[top - 1].IsNegative());
+        break;
+      default:
+        --top;
+        stack[top - 1] = arithmetic.Calculate(
+            stack[top - 1], instruction.operation, stack[top]);
+        break;
+    }
+  }
+  return stack[0];
+}
+
+void Expression::Evaluate(const uint32_t *operands, const size_t sets,
+                          uint32_t *results) {
+  for (size_t i = 0; i < sets; ++i) {
+    for (uint32_t j = 0; j < variables_count; ++j) {
+      uint32_t number = operands[i * variables_count + j];
+      if (format == 'h') {
+        number = (uint16_t)number;
+      }
+      variables[j] = FloatingNumber(number, format, rounding_type);
+    }
+    results[i] = Evaluate(variables.data()).Encode();
+  }
+}
+
+bool Expression::Parse(const int argc, char **argv) {
+  if (!(argc == 4 || argc == 5)) {
+    return false;
+  }
+  if (argc == 5) {
+    if (strcmp(argv[4], "d") != 0) {
+      return false;
+    }
+    decimal_output = true;
+  }
+  if (!(strlen(argv[1]) == 1 && (argv[1][0] == 'h' || argv[1][0] == 'f'))) {
+    return false;
+  }
+  if (!(strlen(argv[2]) == 1 && argv[2][0] > 47 && argv[2][0] < 52)) {
+    return false;
+  }
+  format = argv[1][0];
+  rounding_type = (argv[2][0] - '0');
+  arithmetic = FloatingPointArithmetic(format, rounding_type);
+  return Compile(argv[3]);
+}
+
+// Prints the result for every set of operands (hex values of a, b, ... in
+// this order) from the standard input, one result per line
+bool Expression::DoOperation() {
+  std::string token;
+  while (true) {
+    for (uint32_t i = 0; i < variables_count; ++i) {
+      if (!(std::cin >> token)) {
+        return i == 0;
+      }
+      uint64_t number = 0;
+      if (!HexToInt(token.c_str(), number)) {
+        return false;
+      }
+      if (format == 'h') {
+        number = (uint16_t)number;
+      }
+      variables[i] = FloatingNumber(number, format, rounding_type);
+    }
+    FloatingNumber result = Evaluate(variables.data());
+    if (decimal_output) {
+      result.PrintDecimal();
+    } else {
+      result.PrintNumber();
+    }
+    std::cout << '\n';
+    if (variables_count == 0) {
+      return true;
+    }
+  }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "FloatingPoint.h"
+
+// Step of the compiled expression: push a variable ('v') or a constant
+// ('c') with the given index, negate the top ('n') or apply a binary
+// operation ('+', '-', '*', '/') to the two top numbers
+struct Instruction {
+  uint8_t operation = '+';
+  uint32_t index = 0;
+};
+
+// Arithmetic expression over variables a..z and hex constants, e.g.
+// "(a * b + c) / d". It is parsed once into postfix instructions and then
+// evaluated for many sets of operands, intermediates stay decoded and are
+// rounded after every operation like in DoOperation.
+class Expression {
+  uint8_t format = 'f';
+  uint8_t rounding_type = 0;
+  bool decimal_output = false;
+  FloatingPointArithmetic arithmetic;
+
+  std::vector<Instruction> instructions;
+  std::vector<FloatingNumber> constants;
+  std::vector<FloatingNumber> stack;
+  std::vector<FloatingNumber> variables;
+  uint32_t variables_count = 0;
+  uint32_t depth = 0;
+
+  const char *text = nullptr;
+
+  void SkipSpaces();
+
+  bool ParseSum();
+
+  bool ParseProduct();
+
+  bool ParseFactor();
+
+  void AddInstruction(const uint8_t operation, const uint32_t index);
+
+ public:
+  Expression(const uint8_t format, const uint8_t rounding_type);
+
+  Expression();
+
+  bool Compile(const char *expression);
+
+  uint32_t GetVariablesCount() const;
+
+  FloatingNumber Evaluate(const FloatingNumber *operands);
+
+  void Evaluate(const uint32_t *operands, const size_t sets,
+                uint32_t *results);
+
+  bool Parse(const int argc, char **argv);
+
+  bool DoOperation();
+};
@@ -1,38 +1,13 @@
 #include "FixedPoint.h"
 
-void FixedPointArithmetic::Module(uint32_t& number) {
-  if ((integer_size + fractional_size) < 32) {
-    uint32_t range = 1 << (integer_size + fractional_size);
-    number %= range;
-  }
-}
+#include "HexNumber.h"
 
-bool FixedPointArithmetic::HexToInt(const char* arg, uint32_t& number) {
-  if (arg[0] != '0' || arg[1] != 'x') {
-    return false;
-  }
-  size_t arg_size = strlen(arg);
-  int digit;
-  int j = 1;
-  for (int i = arg_size - 1; i > 1; --i) {
-    if ((arg_size - 1 - i) == 8) {
-      break;
-    }
-    if (isdigit(arg[i])) {
-      digit = arg[i] - 48;
-    } else if (arg[i] > 64 && arg[i] < 71) {
-      digit = arg[i] - 55;
-    } else if (arg[i] > 96 && arg[i] < 103) {
-      digit = arg[i] - 87;
-    } else {
-      return false;
-    }
-    number += digit * j;
-    j *= 16;
-  }
-  Module(number);
-  return true;
-}
+// constant operands are rounded by the compiler, e.g. 1 / 3 in 8.8
+static_assert([] {
+  uint64_t result = 0;
+  FixedPointArithmetic(8, 8, 1).Calculate(0x100, '/', 0x300, result);
+  return result;
+}() == 0x55);
 
 bool FixedPointArithmetic::ReadFormat(const char* arg) {
   size_t i = 0;
@@ -54,92 +29,19 @@ bool FixedPointArithmetic::ReadFormat(const char* arg) {
   return true;
 }
 
-void FixedPointArithmetic::Round(uint64_t& number, const uint32_t divider,
-                                       const bool is_negative) {
-  uint64_t remainder = number % divider;
-  number /= divider;
-  if (remainder != 0) {
-    switch (rounding_type) {
-      case 1:
-        if ((remainder * 2 > divider) ||
-            (remainder * 2 == divider && number % 2 == 1)) {
-          number += 1;
-        }
-        break;
-      case 2:
-        if (!is_negative) {
-          number += 1;
-        }
-        break;
-      case 3:
-        if (is_negative) {
-          number += 1;
-        }
-        break;
-    }
-  }
-}
-
-uint32_t FixedPointArithmetic::Negation(const uint32_t number) {
-  if (number == 0) {
-    return number;
-  }
-  uint64_t range = uint64_t(1) << (integer_size + fractional_size);
-  return range - number;
-}
-
-void FixedPointArithmetic::Multiplication(uint32_t& result) {
-  bool is_negative = false;
-  if ((number1 >> (integer_size + fractional_size - 1)) % 2 != 0) {
-    number1 = Negation(number1);
-    is_negative = !is_negative;
-  }
-  if ((number2 >> (integer_size + fractional_size - 1)) % 2 != 0) {
-    number2 = Negation(number2);
-    is_negative = !is_negative;
-  }
-  uint64_t pre_result = ((uint64_t)number1 * number2);
-  uint32_t divider = (1 << fractional_size);
-  Round(pre_result, divider, is_negative);
-  if (is_negative) {
-    pre_result = Negation(pre_result);
-  }
-  result = pre_result;
-}
-
-bool FixedPointArithmetic::Division(uint32_t& result) {
-  if (number2 == 0) {
-    std::cout << "division by zero";
-    return false;
-  }
-  bool is_negative = false;
-  if ((number1 >> (integer_size + fractional_size - 1)) % 2 != 0) {
-    number1 = Negation(number1);
-    is_negative = !is_negative;
-  }
-  if ((number2 >> (integer_size + fractional_size - 1)) % 2 != 0) {
-    number2 = Negation(number2);
-    is_negative = !is_negative;
-  }
-  uint64_t pre_result = ((uint64_t)number1 << fractional_size);
-  Round(pre_result, number2, is_negative);
-  if (is_negative) {
-    pre_result = Negation(pre_result);
-  }
-  result = pre_result;
-  return true;
-}
-
-void FixedPointArithmetic::PrintNumber(uint32_t number) {
+void FixedPointArithmetic::PrintNumber(uint64_t number) {
   bool is_negative = false;
   if (number >> (integer_size + fractional_size - 1) == 1) {
     number = Negation(number);
     is_negative = true;
   }
-  uint32_t integer_part = number >> fractional_size;
-  uint64_t fractional_part =
-      (uint64_t)(number - (number >> fractional_size << fractional_size)) * 1000;
-   Round(fractional_part, (uint64_t)1 << fractional_size, is_negative);
+  // shifts by up to 64 bits are done in 128 bits
+  unsigned __int128 module = number;
+  uint64_t integer_part = module >> fractional_size;
+  unsigned __int128 thousandths =
+      (module - (module >> fractional_size << fractional_size)) * 1000;
+  Round(thousandths, (unsigned __int128)1 << fractional_size, is_negative);
+  uint64_t fractional_part = thousandths;
   if (fractional_part == 1000) {
     integer_part += 1;
     fractional_part = 0;
@@ -161,7 +63,7 @@ bool FixedPointArithmetic::Parse(const int argc, char** argv) {
   if (!ReadFormat(argv[1])) {
     return false;
   }
-  if ((fractional_size + integer_size) > 32) {
+  if ((fractional_size + integer_size) > 64) {
     return false;
   }
   if (!(strlen(argv[2]) == 1 && argv[2][0] > 47 && argv[2][0] < 52)) {
@@ -174,6 +76,7 @@ bool FixedPointArithmetic::Parse(const int argc, char** argv) {
   if (!HexToInt(argv[3], number1)) {
     return false;
   }
+  Module(number1);
   if (argc == 4) {
     return true;
   }
@@ -185,30 +88,15 @@ bool FixedPointArithmetic::Parse(const int argc, char** argv) {
   if (!HexToInt(argv[5], number2)) {
     return false;
   }
+  Module(number2);
   return true;
 }
 
 void FixedPointArithmetic::DoOperation() {
-  uint32_t result;
-  switch (operation) {
-    case '+':
-      result = number1 + number2;
-      break;
-    case '-':
-      result = number1 + Negation(number2);
-      break;
-    case '*':
-      Multiplication(result);
-      break;
-    case '/':
-      if (!Division(result)) {
-        return;
-      }
-      break;
-    case '=':
-      result = number1;
-      break;
-  }
-  Module(result);
+  uint64_t result;
+  if (!Calculate(number1, operation, number2, result)) {
+    std::cout << "division by zero";
+    return;
+  }
   PrintNumber(result);
-}
\ No newline at end of file
+}
@@ -3,33 +3,322 @@
 #include <cstring>
 #include <iostream>
 
+struct FixedInterval {
+  uint64_t lower = 0;
+  uint64_t upper = 0;
+};
+
+// A.B numbers of up to 64 bits in two's complement, products and shifted
+// dividends are kept in 128 bits before rounding
 class FixedPointArithmetic {
   uint8_t integer_size = 0;
   uint8_t fractional_size = 0;
   uint8_t rounding_type = 0;
   uint8_t operation = '=';
-  uint32_t number1 = 0;
-  uint32_t number2 = 0;
-
-  void Module(uint32_t& number);
+  uint64_t number1 = 0;
+  uint64_t number2 = 0;
 
-  bool HexToInt(const char* arg, uint32_t& number);
+  constexpr void Module(uint64_t& number);
 
   bool ReadFormat(const char* arg);
 
-  void Round(uint64_t& number, const uint32_t divider, const bool is_negative);
+  constexpr void Round(unsigned __int128& number,
+                       const unsigned __int128 divider,
+                       const bool is_negative);
+
+  constexpr uint64_t Negation(const uint64_t number);
+
+  constexpr int64_t ToSigned(const uint64_t number);
+
+  constexpr void Multiplication(unsigned __int128& pre_result,
+                                unsigned __int128& divider, bool& is_negative);
 
-  uint32_t Negation(const uint32_t number);
+  constexpr bool Division(unsigned __int128& pre_result,
+                          unsigned __int128& divider, bool& is_negative);
 
-  void Multiplication(uint32_t& result);
+  constexpr uint64_t RoundResult(unsigned __int128 pre_result,
+                                 const unsigned __int128 divider,
+                                 const bool is_negative);
 
-  bool Division(uint32_t& result);
+  constexpr bool CalculateBounds(const uint64_t first, const uint8_t operation,
+                                 const uint64_t second, uint64_t& lower,
+                                 uint64_t& upper);
 
-  void PrintNumber(uint32_t number);
+  void PrintNumber(uint64_t number);
 
  public:
+  constexpr FixedPointArithmetic(const uint8_t integer_size,
+                                 const uint8_t fractional_size,
+                                 const uint8_t rounding_type);
+
+  constexpr FixedPointArithmetic();
+
+  constexpr bool Calculate(const uint64_t first, const uint8_t operation,
+                           const uint64_t second, uint64_t& result);
+
+  constexpr bool CalculateInterval(const FixedInterval& first,
+                                   const uint8_t operation,
+                                   const FixedInterval& second,
+                                   FixedInterval& result);
 
   bool Parse(const int argc, char** argv);
 
   void DoOperation();
 };
+
+// Arithmetic usable in constant expressions, input and output are in
+// FixedPoint.cpp
+constexpr void FixedPointArithmetic::Module(uint64_t& number) {
+  if ((integer_size + fractional_size) < 64) {
+    uint64_t range = uint64_t(1) << (integer_size + fractional_size);
+    number %= range;
+  }
+}
+
+constexpr void FixedPointArithmetic::Round(unsigned __int128& number,
+                                           const unsigned __int128 divider,
+                                           const bool is_negative) {
+  unsigned __int128 remainder = number % divider;
+  number /= divider;
+  if (remainder != 0) {
+    switch (rounding_type) {
+      case 1:
+        if ((remainder * 2 > divider) ||
+            (remainder * 2 == divider && number % 2 == 1)) {
+          number += 1;
+        }
+        break;
+      case 2:
+        if (!is_negative) {
+          number += 1;
+        }
+        break;
+      case 3:
+        if (is_negative) {
+          number += 1;
+        }
+        break;
+    }
+  }
+}
+
+constexpr uint64_t FixedPointArithmetic::Negation(const uint64_t number) {
+  uint64_t result = -number;
+  Module(result);
+  return result;
+}
+
+constexpr int64_t FixedPointArithmetic::ToSigned(const uint64_t number) {
+  int32_t shift = 64 - (integer_size + fractional_size);
+  return (int64_t)(number << shift) >> shift;
+}
+
+constexpr void FixedPointArithmetic::Multiplication(
+    unsigned __int128& pre_result, unsigned __int128& divider,
+    bool& is_negative) {
+  is_negative = false;
+  if ((number1 >> (integer_size + fractional_size - 1)) % 2 != 0) {
+    number1 = Negation(number1);
+    is_negative = !is_negative;
+  }
+  if ((number2 >> (integer_size + fractional_size - 1)) % 2 != 0) {
+    number2 = Negation(number2);
+    is_negative = !is_negative;
+  }
+  pre_result = ((unsigned __int128)number1 * number2);
+  divider = ((unsigned __int128)1 << fractional_size);
+}
+
+constexpr bool FixedPointArithmetic::Division(unsigned __int128& pre_result,
+                                              unsigned __int128& divider,
+                                              bool& is_negative) {
+  if (number2 == 0) {
+    return false;
+  }
+  is_negative = false;
+  if ((number1 >> (integer_size + fractional_size - 1)) % 2 != 0) {
+    number1 = Negation(number1);
+    is_negative = !is_negative;
+  }
+  if ((number2 >> (integer_size + fractional_size - 1)) % 2 != 0) {
+    number2 = Negation(number2);
+    is_negative = !is_negative;
+  }
+  pre_result = ((unsigned __int128)number1 << fractional_size);
+  divider = number2;
+  return true;
+}
+
+constexpr uint64_t FixedPointArithmetic::RoundResult(
+    unsigned __int128 pre_result, const unsigned __int128 divider,
+    const bool is_negative) {
+  Round(pre_result, divider, is_negative);
+  // bits above 64 are lost on the wrap-around anyway
+  uint64_t result = pre_result;
+  if (is_negative) {
+    result = Negation(result);
+  }
+  Module(result);
+  return result;
+}
+
+// Exact result of the operation rounded down and up, returns false if it
+// does not fit the format (the result would wrap around) or on division by
+// zero
+constexpr bool FixedPointArithmetic::CalculateBounds(const uint64_t first,
+                                                     const uint8_t operation,
+                                                     const uint64_t second,
+                                                     uint64_t& lower,
+                                                     uint64_t& upper) {
+  const int32_t size = integer_size + fractional_size;
+  if (operation == '+' || operation == '-') {
+    __int128 sum = ToSigned(first);
+    if (operation == '+') {
+      sum += ToSigned(second);
+    } else {
+      sum -= ToSigned(second);
+    }
+    if (sum < -((__int128)1 << (size - 1)) ||
+        sum >= ((__int128)1 << (size - 1))) {
+      return false;
+    }
+    Calculate(first, operation, second, lower);
+    upper = lower;
+    return true;
+  }
+  if (operation != '*' && operation != '/') {
+    if (!Calculate(first, operation, second, lower)) {
+      return false;
+    }
+    upper = lower;
+    return true;
+  }
+  number1 = first;
+  number2 = second;
+  unsigned __int128 pre_result = 0;
+  unsigned __int128 divider = 1;
+  bool is_negative = false;
+  if (operation == '*') {
+    Multiplication(pre_result, divider, is_negative);
+  } else if (!Division(pre_result, divider, is_negative)) {
+    return false;
+  }
+  uint8_t rounding = rounding_type;
+  // the module is the largest when rounded away from zero, a negative one
+  // may reach 2^(size - 1)
+  rounding_type = is_negative ? 3 : 2;
+  unsigned __int128 module = pre_result;
+  Round(module, divider, is_negative);
+  if (module > ((unsigned __int128)1 << (size - 1)) - !is_negative) {
+    rounding_type = rounding;
+    return false;
+  }
+  rounding_type = 3;
+  lower = RoundResult(pre_result, divider, is_negative);
+  rounding_type = 2;
+  upper = RoundResult(pre_result, divider, is_negative);
+  rounding_type = rounding;
+  return true;
+}
+
+constexpr FixedPointArithmetic::FixedPointArithmetic(
+    const uint8_t integer_size, const uint8_t fractional_size,
+    const uint8_t rounding_type)
+    : integer_size(integer_size),
+      fractional_size(fractional_size),
+      rounding_type(rounding_type) {}
+
+constexpr FixedPointArithmetic::FixedPointArithmetic() = default;
+
+// Returns false on division by zero or an unknown operation
+constexpr bool FixedPointArithmetic::Calculate(const uint64_t first,
+                                               const uint8_t operation,
+                                               const uint64_t second,
+                                               uint64_t& result) {
+  number1 = first;
+  number2 = second;
+  unsigned __int128 pre_result = 0;
+  unsigned __int128 divider = 1;
+  bool is_negative = false;
+  switch (operation) {
+    case '+':
+      result = number1 + number2;
+      break;
+    case '-':
+      result = number1 + Negation(number2);
+      break;
+    case '*':
+      Multiplication(pre_result, divider, is_negative);
+      result = RoundResult(pre_result, divider, is_negative);
+      break;
+    case '/':
+      if (!Division(pre_result, divider, is_negative)) {
+        return false;
+      }
+      result = RoundResult(pre_result, divider, is_negative);
+      break;
+    case '=':
+      result = number1;
+      break;
+    default:
+      return false;
+  }
+  Module(result);
+  return true;
+}
+
+constexpr bool FixedPointArithmetic::CalculateInterval(
+    const FixedInterval& first, const uint8_t operation,
+    const FixedInterval& second, FixedInterval& result) {
+  if (operation == '/' && ToSigned(second.lower) <= 0 &&
+      ToSigned(second.upper) >= 0) {
+    return false;
+  }
+  if (operation == '+' || operation == '-') {
+    // the sums are exact, the lower end comes from the lower ends (and the
+    // upper end of the subtrahend), the upper end from the other ones
+    const uint64_t lower2 = (operation == '+') ? second.lower : second.upper;
+    const uint64_t upper2 = (operation == '+') ? second.upper : second.lower;
+    uint64_t unused = 0;
+    if (!CalculateBounds(first.lower, operation, lower2, result.lower,
+                         unused)) {
+      return false;
+    }
+    if (first.lower == first.upper && lower2 == upper2) {
+      result.upper = result.lower;
+      return true;
+    }
+    return CalculateBounds(first.upper, operation, upper2, unused,
+                           result.upper);
+  }
+  // the bounds are reached at the ends of the operands, every end pair is
+  // evaluated once and rounded both down and up
+  const uint64_t ends1[2] = {first.lower, first.upper};
+  const uint64_t ends2[2] = {second.lower, second.upper};
+  bool is_done[2][2] = {};
+  bool is_empty = true;
+  for (int32_t i = 0; i < 2; ++i) {
+    for (int32_t j = 0; j < 2; ++j) {
+      int32_t k = (first.lower == first.upper) ? 0 : i;
+      int32_t l = (second.lower == second.upper) ? 0 : j;
+      if (is_done[k][l]) {
+        continue;
+      }
+      is_done[k][l] = true;
+      uint64_t lower;
+      uint64_t upper;
+      if (!CalculateBounds(ends1[k], operation, ends2[l], lower, upper)) {
+        // the operation wraps around, the bounds would not enclose it
+        return false;
+      }
+      if (is_empty || ToSigned(lower) < ToSigned(result.lower)) {
+        result.lower = lower;
+      }
+      if (is_empty || ToSigned(upper) > ToSigned(result.upper)) {
+        result.upper = upper;
+      }
+      is_empty = false;
+    }
+  }
+  return true;
+}
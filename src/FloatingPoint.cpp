@@ -1,144 +1,17 @@
 #include "FloatingPoint.h"
 
-FloatingNumber::FloatingNumber(uint32_t number, const uint8_t format,
-                               const uint8_t rounding_type)
-    : format(format), rounding_type(rounding_type) {
-  FixFormat();
-  mantissa = number % (1 << mantissa_size);
-  number >>= mantissa_size;
-  exponent = number % (1 << exponent_size) - exponent_shift;
-  number >>= exponent_size;
-  is_negative = number;
-  if ((exponent == min_exponent) && (mantissa == 0)) {
-    is_null = true;
-  }
-  if (exponent == min_exponent && mantissa != 0) {
-    exponent = min_exponent + 1;
-    while ((mantissa << 1) < (1 << (mantissa_size + 1))) {
-      --exponent;
-      mantissa <<= 1;
-    }
-    mantissa %= (1 << mantissa_size);
-  }
-}
-
-FloatingNumber::FloatingNumber(const uint8_t format,
-                               const uint8_t rounding_type)
-    : format(format), rounding_type(rounding_type) {
-  FixFormat();
-}
-
-FloatingNumber::FloatingNumber() = default;
-
-void FloatingNumber::FixFormat() {
-  if (format == 'h') {
-    mantissa_size = 10;
-    exponent_size = 5;
-    exponent_shift = 15;
-    max_exponent = 16;
-    min_exponent = -15;
-  }
-}
-
-uint32_t FloatingNumber::GetMantissa() const {
-  return (1 << mantissa_size) + mantissa;
-}
-
-void FloatingNumber::ChangeSign(const bool is_neg) { is_negative = is_neg; }
-
-void FloatingNumber::MakeInfinity() {
-  exponent = max_exponent;
-  mantissa = 0;
-}
-
-void FloatingNumber::MakeNan() {
-  exponent = max_exponent;
-  mantissa = 1;
-}
-
-void FloatingNumber::MakeNull() {
-  exponent = min_exponent;
-  mantissa = 0;
-  is_null = true;
-}
-
-void FloatingNumber::MakeMaxFinite() {
-  exponent = max_exponent - 1;
-  mantissa = (1 << mantissa_size) - 1;
-}
-
-void FloatingNumber::MakeMinFinite() {
-  exponent = min_exponent - mantissa_size + 1;
-  mantissa = 0;
-}
-
-bool FloatingNumber::IsNegative() const { return is_negative; }
-
-bool FloatingNumber::IsInfinity() const {
-  return (exponent == max_exponent) && mantissa == 0;
-}
-
-bool FloatingNumber::IsNan() const {
-  return (exponent == max_exponent) && mantissa != 0;
-}
-
-bool FloatingNumber::IsNull() const {
-  return is_null;
-}
-
-void FloatingNumber::FixOverflow() {
-  switch (rounding_type) {
-    case 0:
-      MakeMaxFinite();
-      return;
-    case 1:
-      MakeInfinity();
-      return;
-    case 2:
-      if (is_negative) {
-        MakeMaxFinite();
-        return;
-      }
-      MakeInfinity();
-      return;
-    case 3:
-      if (is_negative) {
-        MakeInfinity();
-        return;
-      }
-      MakeMaxFinite();
-      return;
-  }
-}
-
-void FloatingNumber::FixUnderflow() {
-  switch (rounding_type) {
-    case 0:
-      MakeNull();
-      return;
-    case 1:
-      if ((exponent == min_exponent - mantissa_size) && mantissa != 0) {
-        MakeMinFinite();
-        return;
-      }
-      MakeNull();
-      return;
-    case 2:
-      if (is_negative) {
-        MakeNull();
-        return;
-      }
-      MakeMinFinite();
-      return;
-    case 3:
-      if (is_negative) {
-        MakeMinFinite();
-        return;
-      }
-      MakeNull();
-      return;
-  }
-}
+#include "HexNumber.h"
+
+// constant operands are rounded by the compiler, e.g. 1 / 3 and
+// 0.1 * 3 in both formats with rounding to nearest
+static_assert(FloatingPointArithmetic('f', 1)
+                  .Calculate(FloatingNumber(0x3f800000, 'f', 1), '/',
+                             FloatingNumber(0x40400000, 'f', 1))
+                  .Encode() == 0x3eaaaaab);
+static_assert(FloatingPointArithmetic('h', 1)
+                  .Calculate(FloatingNumber(0x2e66, 'h', 1), '*',
+                             FloatingNumber(0x4200, 'h', 1))
+                  .Encode() == 0x34cc);
 
 void FloatingNumber::PrintNumber() const {
   if (IsNan()) {
@@ -171,279 +44,169 @@ void FloatingNumber::PrintNumber() const {
   std::cout << exponent;
 }
 
-bool FloatingPointArithmetic::HexToInt(const char *arg, uint32_t &number) {
-  if (arg[0] != '0' || arg[1] != 'x') {
-    return false;
+void FloatingNumber::PrintDecimal() const {
+  if (IsNan()) {
+    std::cout << "nan";
+    return;
   }
-  size_t arg_size = strlen(arg);
-  int digit;
-  int j = 1;
-  for (int i = arg_size - 1; i > 1; --i) {
-    if ((arg_size - 1 - i) == 8) {
-      break;
-    }
-    if (isdigit(arg[i])) {
-      digit = arg[i] - 48;
-    } else if (arg[i] > 64 && arg[i] < 71) {
-      digit = arg[i] - 55;
-    } else if (arg[i] > 96 && arg[i] < 103) {
-      digit = arg[i] - 87;
-    } else {
-      return false;
-    }
-    number += digit * j;
-    j *= 16;
+  if (IsNegative()) {
+    std::cout << '-';
   }
-  if (format == 'h') {
-    number = (uint16_t)number;
+  if (IsInfinity()) {
+    std::cout << "inf";
+    return;
   }
-  return true;
-}
-
-void FloatingPointArithmetic::Round(uint64_t &number, const uint64_t divider,
-                                    const bool is_negative) {
-  uint64_t remainder = number % divider;
-  number /= divider;
-  if (remainder != 0) {
-    switch (rounding_type) {
-      case 1:
-        if ((remainder * 2 > divider) ||
-            (remainder * 2 == divider && number % 2 == 1)) {
-          number += 1;
-        }
-        break;
-      case 2:
-        if (!is_negative) {
-          number += 1;
-        }
-        break;
-      case 3:
-        if (is_negative) {
-          number += 1;
-        }
-        break;
-    }
+  if (IsNull()) {
+    std::cout << "0e+0";
+    return;
   }
+  uint32_t number = Encode();
+  uint32_t ieee_mantissa = number % (1 << mantissa_size);
+  uint32_t ieee_exponent = (number >> mantissa_size) % (1 << exponent_size);
+  DecimalNumber(ieee_mantissa, ieee_exponent, mantissa_size, exponent_shift)
+      .PrintNumber();
 }
 
-void FloatingPointArithmetic::Normalize(FloatingNumber &result,
-                                        uint64_t &mantissa, int32_t exponent,
-                                        const bool is_negative,
-                                        uint64_t mantissa1 = 0,
-                                        uint64_t divider = 1) {
-  result.is_negative = is_negative;
-  int32_t point_shift = 0;
-  uint32_t i = 0;
-  uint64_t mantissa_copy = mantissa;
-  while (mantissa_copy > 0) {
-    if (mantissa_copy % 2 == 1) {
-      point_shift = i;
+void FloatingPointArithmetic::Accumulate(const uint32_t *numbers,
+                                         const size_t size,
+                                         const bool is_square,
+                                         WideAccumulator &sum) const {
+  for (size_t i = 0; i < size; ++i) {
+    uint32_t bits = numbers[i];
+    if (format == 'h') {
+      bits = (uint16_t)bits;
     }
-    ++i;
-    mantissa_copy /= 2;
-  }
-  while (point_shift - mantissa_size < 0) {
-    point_shift++;
-    exponent--;
-    mantissa <<= 1;
-  }
-  exponent += point_shift;
-  if (exponent >= max_exponent) {
-    result.FixOverflow();
-    return;
-  }
-  if (exponent < (min_exponent - mantissa_size + 1)) {
-    if (mantissa % ((uint64_t)1 << point_shift) == 0) {
-      result.mantissa = 0;
+    FloatingNumber number(bits, format, rounding_type);
+    if (number.IsNan()) {
+      sum.is_nan = true;
+      continue;
+    }
+    bool is_negative = number.IsNegative() && !is_square;
+    if (is_negative) {
+      sum.has_negative = true;
     } else {
-      result.mantissa = 1;
+      sum.has_positive = true;
     }
-    result.exponent = exponent;
-    result.FixUnderflow();
-    return;
+    if (number.IsInfinity()) {
+      if (is_negative) {
+        sum.is_negative_infinity = true;
+      } else {
+        sum.is_positive_infinity = true;
+      }
+      continue;
+    }
+    if (number.IsNull()) {
+      continue;
+    }
+    uint64_t mantissa = number.GetMantissa();
+    int32_t exponent = number.exponent - mantissa_size;
+    if (is_square) {
+      mantissa *= mantissa;
+      exponent *= 2;
+    }
+    sum.Add(mantissa, exponent, is_negative);
   }
-  uint32_t denormal_digits = 0;
-  if (exponent <= min_exponent) {
-    denormal_digits = min_exponent - exponent + 1;
+}
+
+WideAccumulator FloatingPointArithmetic::Reduce(const uint32_t *numbers,
+                                                const size_t size,
+                                                uint32_t threads,
+                                                const bool is_square) const {
+  // the last bit of the least denormal number (squared)
+  int32_t lowest_exponent = min_exponent - 2 * mantissa_size + 1;
+  if (is_square) {
+    lowest_exponent *= 2;
   }
-  divider *= ((uint64_t)1 << (point_shift - mantissa_size + denormal_digits));
-  if (mantissa1 != 0) {
-    mantissa = mantissa1;
+  if (threads == 0) {
+    threads = 1;
   }
-  Round(mantissa, divider, is_negative);
-  if (mantissa >= ((uint64_t)1 << (mantissa_size - denormal_digits + 1))) {
-    exponent += 1;
-    if (exponent >= max_exponent) {
-      result.FixOverflow();
-      return;
-    }
-    mantissa >>= 1;
+  std::vector<WideAccumulator> sums(threads, WideAccumulator(lowest_exponent));
+  std::vector<std::thread> workers;
+  size_t chunk = (size + threads - 1) / threads;
+  for (uint32_t i = 1; i < threads; ++i) {
+    size_t begin = std::min(size, i * chunk);
+    size_t end = std::min(size, begin + chunk);
+    workers.emplace_back(&FloatingPointArithmetic::Accumulate, this,
+                         numbers + begin, end - begin, is_square,
+                         std::ref(sums[i]));
   }
-  mantissa <<= denormal_digits;
-  mantissa %= (1 << mantissa_size);
-  result.mantissa = mantissa;
-  result.exponent = exponent;
+  Accumulate(numbers, std::min(size, chunk), is_square, sums[0]);
+  for (uint32_t i = 1; i < threads; ++i) {
+    workers[i - 1].join();
+    sums[0].Merge(sums[i]);
+  }
+  return sums[0];
 }
 
-void FloatingPointArithmetic::Addition(FloatingNumber &result) {
-  if (number1.IsInfinity() && number2.IsInfinity() &&
-      (number1.IsNegative() ^ number2.IsNegative()) == 1) {
+FloatingNumber FloatingPointArithmetic::RoundSum(const WideAccumulator &sum,
+                                                 const uint64_t divider) {
+  FloatingNumber result(format, rounding_type);
+  if (sum.is_nan || (sum.is_positive_infinity && sum.is_negative_infinity) ||
+      divider == 0) {
     result.MakeNan();
-    return;
-  }
-  if (number1.IsInfinity()) {
-    result.MakeInfinity();
-    result.ChangeSign(number1.is_negative);
-    return;
+    return result;
   }
-  if (number2.IsInfinity()) {
+  if (sum.is_positive_infinity || sum.is_negative_infinity) {
     result.MakeInfinity();
-    result.ChangeSign(number2.is_negative);
-    return;
-  }
-  if (number1.exponent == number2.exponent &&
-      number1.mantissa == number2.mantissa &&
-      (number1.IsNegative() ^ number2.IsNegative()) == 1) {
+    result.ChangeSign(sum.is_negative_infinity);
+    return result;
+  }
+  // the whole sum is divided, so the quotient is rounded exactly for any
+  // divider
+  WideAccumulator quotient = sum;
+  if (divider != 1) {
+    quotient.Divide(divider);
+  }
+  UnroundedNumber unrounded;
+  if (!quotient.GetModule(unrounded.mantissa, unrounded.exponent,
+                          unrounded.is_negative)) {
+    // zeros keep their common sign, otherwise it depends on the rounding
     result.MakeNull();
-    if (rounding_type == 3) {
-      result.is_negative = true;
+    if (!sum.has_positive) {
+      result.ChangeSign(sum.has_negative);
+    } else if (sum.has_negative) {
+      result.ChangeSign(rounding_type == 3);
     }
-    return;
-  }
-  if (number1.IsNull()) {
-    result = number2;
-    return;
-  }
-  if (number2.IsNull()) {
-    result = number1;
-    return;
-  }
-  uint64_t mantissa1 = number1.GetMantissa();
-  uint64_t mantissa2 = number2.GetMantissa();
-  int32_t exponent1 = number1.exponent;
-  int32_t exponent2 = number2.exponent;
-  bool is_negative1 = number1.is_negative;
-  bool is_negative2 = number2.is_negative;
-  if (exponent2 > exponent1) {
-    std::swap(exponent1, exponent2);
-    std::swap(mantissa1, mantissa2);
-    std::swap(is_negative1, is_negative2);
-  }
-  uint64_t mantissa;
-  int32_t exponent;
-  bool is_negative = false;
-  if ((exponent1 - exponent2) > (mantissa_size + 2)) {
-    mantissa = mantissa1;
-    exponent = exponent1 - mantissa_size;
-    is_negative = is_negative1;
-    if ((is_negative1 ^ is_negative2) == 0) {
-      if ((!is_negative && rounding_type == 2) ||
-          (is_negative && rounding_type == 3)) {
-        mantissa += 1;
-        Normalize(result, mantissa, exponent, is_negative);
-      }
-    } else {
-      if ((rounding_type == 0) || (!is_negative && rounding_type == 3) ||
-          (is_negative && rounding_type == 2)) {
-        mantissa -= 1;
-        Normalize(result, mantissa, exponent, is_negative);
-        if (exponent1 - result.exponent == 1) {
-          result.mantissa += 1;
-        }
-      }
-    }
-    return;
-  }
-  while (exponent1 != exponent2) {
-    mantissa1 <<= 1;
-    --exponent1;
-  }
-  exponent = exponent1 - mantissa_size;
-  if ((is_negative1 ^ is_negative2) == 0) {
-    is_negative = is_negative1;
-    mantissa = mantissa1 + mantissa2;
-  } else if (mantissa1 > mantissa2) {
-    is_negative = is_negative1;
-    mantissa = mantissa1 - mantissa2;
-  } else {
-    is_negative = is_negative2;
-    mantissa = mantissa2 - mantissa1;
+    return result;
   }
-  Normalize(result, mantissa, exponent, is_negative);
+  Normalize(result, unrounded);
+  return result;
 }
 
-void FloatingPointArithmetic::Subtraction(FloatingNumber &result) {
-  number2.is_negative = !number2.is_negative;
-  Addition(result);
+FloatingNumber FloatingPointArithmetic::Sum(const uint32_t *numbers,
+                                            const size_t size,
+                                            const uint32_t threads) {
+  return RoundSum(Reduce(numbers, size, threads, false), 1);
 }
 
-void FloatingPointArithmetic::Multiplication(FloatingNumber &result) {
-  if ((number1.IsNull() && number2.IsInfinity()) ||
-      (number2.IsNull() && number1.IsInfinity())) {
-    result.MakeNan();
-    return;
-  }
-  if (number1.IsInfinity() || number2.IsInfinity()) {
-    result.MakeInfinity();
-    result.ChangeSign(number1.IsNegative() ^ number2.IsNegative());
-    return;
-  }
-  if (number1.IsNull() || number2.IsNull()) {
-    result.MakeNull();
-    result.ChangeSign(number1.IsNegative() ^ number2.IsNegative());
-    return;
-  }
-  int32_t exponent = number1.exponent + number2.exponent - 2 * mantissa_size;
-  uint64_t mantissa1 = number1.GetMantissa();
-  uint64_t mantissa2 = number2.GetMantissa();
-  uint64_t mantissa = mantissa1 * mantissa2;
-  bool is_negative = number1.IsNegative() ^ number2.IsNegative();
-  Normalize(result, mantissa, exponent, is_negative);
+FloatingNumber FloatingPointArithmetic::Mean(const uint32_t *numbers,
+                                             const size_t size,
+                                             const uint32_t threads) {
+  return RoundSum(Reduce(numbers, size, threads, false), size);
 }
 
-void FloatingPointArithmetic::Division(FloatingNumber &result) {
-  if (number1.IsNull() && number2.IsNull()) {
-    result.MakeNan();
-    return;
-  }
-  if (number1.IsInfinity() && number2.IsInfinity()) {
-    result.MakeNan();
-    return;
-  }
-  if (number1.IsInfinity() || number2.IsNull()) {
-    result.MakeInfinity();
-    result.ChangeSign(number1.IsNegative() ^ number2.IsNegative());
-    return;
-  }
-  if (number1.IsNull() || number2.IsInfinity()) {
-    result.MakeNull();
-    result.ChangeSign(number1.IsNegative() ^ number2.IsNegative());
-    return;
-  }
-  int32_t exponent = number1.exponent - number2.exponent - mantissa_size - 1;
-  uint64_t mantissa1 = number1.GetMantissa();
-  uint64_t mantissa2 = number2.GetMantissa();
-  uint64_t mantissa = (mantissa1 << (mantissa_size + 1)) / mantissa2;
-  bool is_negative = number1.IsNegative() ^ number2.IsNegative();
-  Normalize(result, mantissa, exponent, is_negative,
-            mantissa1 << (mantissa_size + 1), mantissa2);
+FloatingNumber FloatingPointArithmetic::SumOfSquares(const uint32_t *numbers,
+                                                     const size_t size,
+                                                     const uint32_t threads) {
+  return RoundSum(Reduce(numbers, size, threads, true), 1);
 }
 
-bool FloatingPointArithmetic::Parse(const int argc, char **argv) {
+bool FloatingPointArithmetic::Parse(int argc, char **argv) {
+  if (argc == 5 || argc == 7) {
+    if (strcmp(argv[argc - 1], "d") != 0) {
+      return false;
+    }
+    decimal_output = true;
+    --argc;
+  }
   if (!(argc == 4 || argc == 6)) {
     return false;
   }
   if (!(argv[1][0] == 'h' || argv[1][0] == 'f')) {
     return false;
   }
-  if (argv[1][0] == 'h') {
-    format = 'h';
-    mantissa_size = 10;
-    exponent_size = 5;
-    exponent_shift = 15;
-    max_exponent = 16;
-    min_exponent = -15;
-  }
+  format = argv[1][0];
+  FixFormat();
   if (!(strlen(argv[2]) == 1 && argv[2][0] > 47 && argv[2][0] < 52)) {
     return false;
   }
@@ -451,10 +214,13 @@ bool FloatingPointArithmetic::Parse(const int argc, char **argv) {
   if (rounding_type < 0 || rounding_type > 3) {
     return false;
   }
-  uint32_t num1 = 0;
+  uint64_t num1 = 0;
   if (!HexToInt(argv[3], num1)) {
     return false;
   }
+  if (format == 'h') {
+    num1 = (uint16_t)num1;
+  }
   number1 = FloatingNumber(num1, format, rounding_type);
   if (argc == 4) {
     return true;
@@ -464,36 +230,22 @@ bool FloatingPointArithmetic::Parse(const int argc, char **argv) {
     return false;
   }
   operation = argv[4][0];
-  uint32_t num2 = 0;
+  uint64_t num2 = 0;
   if (!HexToInt(argv[5], num2)) {
     return false;
   }
+  if (format == 'h') {
+    num2 = (uint16_t)num2;
+  }
   number2 = FloatingNumber(num2, format, rounding_type);
   return true;
 }
 
 void FloatingPointArithmetic::DoOperation() {
-  FloatingNumber result(format, rounding_type);
-  if (number1.IsNan() || number2.IsNan()) {
-    result.MakeNan();
+  FloatingNumber result = Calculate(number1, operation, number2);
+  if (decimal_output) {
+    result.PrintDecimal();
   } else {
-    switch (operation) {
-      case '+':
-        Addition(result);
-        break;
-      case '-':
-        Subtraction(result);
-        break;
-      case '*':
-        Multiplication(result);
-        break;
-      case '/':
-        Division(result);
-        break;
-      case '=':
-        result = number1;
-        break;
-    }
+    result.PrintNumber();
   }
-  result.PrintNumber();
-}
\ No newline at end of file
+}
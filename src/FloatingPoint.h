@@ -1,15 +1,30 @@
 #pragma once
 #include <stdio.h>
 
+#include <bit>
 #include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <thread>
+#include <vector>
+
+#include "DecimalNumber.h"
+#include "WideAccumulator.h"
+
+// Classes of numbers, normal (and renormalized denormal) numbers are zero
+// so that both operands are checked with a single branch
+enum NumberType : uint8_t {
+  kNormal = 0,
+  kNull = 1,
+  kInfinity = 2,
+  kNan = 4,
+};
 
 struct FloatingNumber {
   bool is_negative = false;
-  bool is_null = false;
-  uint32_t mantissa;
-  int32_t exponent;
+  uint8_t type = kNormal;
+  uint32_t mantissa = 0;
+  int32_t exponent = 0;
 
   int32_t mantissa_size = 23;
   int32_t exponent_size = 8;
@@ -20,42 +35,63 @@ struct FloatingNumber {
   uint8_t rounding_type = 0;
   uint8_t format = 'f';
 
-  FloatingNumber(uint32_t number, const uint8_t format,
-                 const uint8_t rounding_type);
+  constexpr FloatingNumber(uint32_t number, const uint8_t format,
+                           const uint8_t rounding_type);
+
+  constexpr FloatingNumber(const uint8_t format, const uint8_t rounding_type);
 
-  FloatingNumber(const uint8_t format, const uint8_t rounding_type);
+  constexpr FloatingNumber();
 
-  FloatingNumber();
+  constexpr void FixFormat();
 
-  void FixFormat();
+  constexpr uint32_t GetMantissa() const;
 
-  uint32_t GetMantissa() const;
+  constexpr uint32_t Encode() const;
 
-  void ChangeSign(const bool is_neg);
+  constexpr void ChangeSign(const bool is_neg);
 
-  void MakeInfinity();
+  constexpr void MakeInfinity();
 
-  void MakeNan();
+  constexpr void MakeNan();
 
-  void MakeNull();
+  constexpr void MakeNull();
 
-  void MakeMaxFinite();
+  constexpr void MakeMaxFinite();
 
-  void MakeMinFinite();
+  constexpr void MakeMinFinite();
 
-  bool IsNegative() const;
+  constexpr bool IsNegative() const;
 
-  bool IsInfinity() const;
+  constexpr bool IsInfinity() const;
 
-  bool IsNan() const;
+  constexpr bool IsNan() const;
 
-  bool IsNull() const;
+  constexpr bool IsNull() const;
 
-  void FixOverflow();
+  constexpr bool IsLess(const FloatingNumber &other) const;
 
-  void FixUnderflow();
+  constexpr void FixOverflow();
+
+  constexpr void FixUnderflow();
 
   void PrintNumber() const;
+
+  void PrintDecimal() const;
+};
+
+// Exact result of an operation before rounding: mantissa * 2^exponent, or
+// mantissa1 / divider * 2^exponent for the division
+struct UnroundedNumber {
+  bool is_negative = false;
+  uint64_t mantissa = 0;
+  int32_t exponent = 0;
+  uint64_t mantissa1 = 0;
+  uint64_t divider = 1;
+};
+
+struct FloatingInterval {
+  FloatingNumber lower;
+  FloatingNumber upper;
 };
 
 class FloatingPointArithmetic {
@@ -64,6 +100,7 @@ class FloatingPointArithmetic {
   FloatingNumber number1;
   FloatingNumber number2;
   uint8_t format = 'f';
+  bool decimal_output = false;
 
   int32_t mantissa_size = 23;
   int32_t exponent_size = 8;
@@ -71,24 +108,677 @@ class FloatingPointArithmetic {
   int32_t max_exponent = 128;
   int32_t min_exponent = -127;
 
-  bool HexToInt(const char *arg, uint32_t &number);
+  constexpr void Round(uint64_t &number, const uint64_t divider,
+                       const bool is_negative);
+
+  constexpr void FixFormat();
+
+  constexpr void Normalize(FloatingNumber &result, UnroundedNumber number);
+
+  constexpr void NormalizeBounds(const UnroundedNumber &number,
+                                 FloatingNumber &lower, FloatingNumber &upper);
+
+  constexpr void Addition(UnroundedNumber &unrounded);
+
+  constexpr void Multiplication(UnroundedNumber &unrounded);
 
-  void Round(uint64_t &number, const uint64_t divider, const bool is_negative);
+  constexpr void Division(UnroundedNumber &unrounded);
 
-  void Normalize(FloatingNumber &result, uint64_t &mantissa, int32_t exponent,
-                 const bool is_negative, uint64_t mantissa1,
-                 uint64_t divider);
+  constexpr bool SpecialAddition(FloatingNumber &result,
+                                 UnroundedNumber &unrounded);
 
-  void Addition(FloatingNumber &result);
+  constexpr void SpecialMultiplication(FloatingNumber &result);
 
-  void Subtraction(FloatingNumber &result);
+  constexpr void SpecialDivision(FloatingNumber &result);
 
-  void Multiplication(FloatingNumber &result);
+  constexpr bool Evaluate(FloatingNumber &result, UnroundedNumber &unrounded);
 
-  void Division(FloatingNumber &result);
+  constexpr void CalculateBounds(const FloatingNumber &first,
+                                 const uint8_t operation,
+                                 const FloatingNumber &second,
+                                 FloatingNumber &lower, FloatingNumber &upper);
+
+  void Accumulate(const uint32_t *numbers, const size_t size,
+                  const bool is_square, WideAccumulator &sum) const;
+
+  WideAccumulator Reduce(const uint32_t *numbers, const size_t size,
+                         uint32_t threads, const bool is_square) const;
+
+  FloatingNumber RoundSum(const WideAccumulator &sum, const uint64_t divider);
 
  public:
-  bool Parse(const int argc, char **argv);
+  constexpr FloatingPointArithmetic(const uint8_t format,
+                                    const uint8_t rounding_type);
+
+  constexpr FloatingPointArithmetic();
+
+  constexpr FloatingNumber Calculate(const FloatingNumber &first,
+                                     const uint8_t operation,
+                                     const FloatingNumber &second);
+
+  constexpr FloatingNumber SquareRoot(const FloatingNumber &number);
+
+  constexpr FloatingInterval CalculateInterval(const FloatingInterval &first,
+                                               const uint8_t operation,
+                                               const FloatingInterval &second);
+
+  FloatingNumber Sum(const uint32_t *numbers, const size_t size,
+                     const uint32_t threads);
+
+  FloatingNumber Mean(const uint32_t *numbers, const size_t size,
+                      const uint32_t threads);
+
+  FloatingNumber SumOfSquares(const uint32_t *numbers, const size_t size,
+                              const uint32_t threads);
+
+  bool Parse(int argc, char **argv);
 
   void DoOperation();
-};
\ No newline at end of file
+};
+
+// Decoding and rounding are defined here as constexpr, printing and parsing
+// stay in FloatingPoint.cpp
+constexpr FloatingNumber::FloatingNumber(uint32_t number, const uint8_t format,
+                                         const uint8_t rounding_type)
+    : rounding_type(rounding_type), format(format) {
+  FixFormat();
+  mantissa = number % (1 << mantissa_size);
+  number >>= mantissa_size;
+  exponent = number % (1 << exponent_size) - exponent_shift;
+  number >>= exponent_size;
+  is_negative = number;
+  if (exponent == max_exponent) {
+    type = (mantissa == 0) ? kInfinity : kNan;
+  } else if (exponent == min_exponent) {
+    if (mantissa == 0) {
+      type = kNull;
+    } else {
+      // denormal, the first significant bit is shifted to the hidden one
+      int32_t shift = std::countl_zero(mantissa) - (31 - mantissa_size);
+      exponent = min_exponent + 1 - shift;
+      mantissa = (mantissa << shift) % (1 << mantissa_size);
+    }
+  }
+}
+
+constexpr FloatingNumber::FloatingNumber(const uint8_t format,
+                                         const uint8_t rounding_type)
+    : rounding_type(rounding_type), format(format) {
+  FixFormat();
+}
+
+constexpr FloatingNumber::FloatingNumber() = default;
+
+constexpr void FloatingNumber::FixFormat() {
+  if (format == 'h') {
+    mantissa_size = 10;
+    exponent_size = 5;
+    exponent_shift = 15;
+    max_exponent = 16;
+    min_exponent = -15;
+  }
+}
+
+constexpr uint32_t FloatingNumber::GetMantissa() const {
+  return (1 << mantissa_size) + mantissa;
+}
+
+constexpr uint32_t FloatingNumber::Encode() const {
+  uint32_t number = is_negative;
+  number <<= exponent_size;
+  if (IsNull()) {
+    return number << mantissa_size;
+  }
+  if (exponent <= min_exponent) {
+    return (number << mantissa_size) +
+           (GetMantissa() >> (min_exponent + 1 - exponent));
+  }
+  number += exponent + exponent_shift;
+  return (number << mantissa_size) + mantissa;
+}
+
+constexpr void FloatingNumber::ChangeSign(const bool is_neg) {
+  is_negative = is_neg;
+}
+
+constexpr void FloatingNumber::MakeInfinity() {
+  exponent = max_exponent;
+  mantissa = 0;
+  type = kInfinity;
+}
+
+constexpr void FloatingNumber::MakeNan() {
+  exponent = max_exponent;
+  mantissa = 1;
+  type = kNan;
+}
+
+constexpr void FloatingNumber::MakeNull() {
+  exponent = min_exponent;
+  mantissa = 0;
+  type = kNull;
+}
+
+constexpr void FloatingNumber::MakeMaxFinite() {
+  exponent = max_exponent - 1;
+  mantissa = (1 << mantissa_size) - 1;
+  type = kNormal;
+}
+
+constexpr void FloatingNumber::MakeMinFinite() {
+  exponent = min_exponent - mantissa_size + 1;
+  mantissa = 0;
+  type = kNormal;
+}
+
+constexpr bool FloatingNumber::IsNegative() const { return is_negative; }
+
+constexpr bool FloatingNumber::IsInfinity() const { return type == kInfinity; }
+
+constexpr bool FloatingNumber::IsNan() const { return type == kNan; }
+
+constexpr bool FloatingNumber::IsNull() const { return type == kNull; }
+
+constexpr bool FloatingNumber::IsLess(const FloatingNumber &other) const {
+  if (IsNull() && other.IsNull()) {
+    return false;
+  }
+  if (is_negative != other.is_negative) {
+    return is_negative;
+  }
+  bool is_less_module;
+  if (IsNull() || other.IsNull()) {
+    is_less_module = IsNull();
+  } else if (exponent != other.exponent) {
+    is_less_module = exponent < other.exponent;
+  } else if (mantissa != other.mantissa) {
+    is_less_module = mantissa < other.mantissa;
+  } else {
+    return false;
+  }
+  return is_less_module ^ is_negative;
+}
+
+constexpr void FloatingNumber::FixOverflow() {
+  switch (rounding_type) {
+    case 0:
+      MakeMaxFinite();
+      return;
+    case 1:
+      MakeInfinity();
+      return;
+    case 2:
+      if (is_negative) {
+        MakeMaxFinite();
+        return;
+      }
+      MakeInfinity();
+      return;
+    case 3:
+      if (is_negative) {
+        MakeInfinity();
+        return;
+      }
+      MakeMaxFinite();
+      return;
+  }
+}
+
+constexpr void FloatingNumber::FixUnderflow() {
+  switch (rounding_type) {
+    case 0:
+      MakeNull();
+      return;
+    case 1:
+      if ((exponent == min_exponent - mantissa_size) && mantissa != 0) {
+        MakeMinFinite();
+        return;
+      }
+      MakeNull();
+      return;
+    case 2:
+      if (is_negative) {
+        MakeNull();
+        return;
+      }
+      MakeMinFinite();
+      return;
+    case 3:
+      if (is_negative) {
+        MakeMinFinite();
+        return;
+      }
+      MakeNull();
+      return;
+  }
+}
+
+constexpr void FloatingPointArithmetic::Round(uint64_t &number,
+                                              const uint64_t divider,
+                                              const bool is_negative) {
+  uint64_t remainder = number % divider;
+  number /= divider;
+  if (remainder != 0) {
+    switch (rounding_type) {
+      case 1:
+        if ((remainder * 2 > divider) ||
+            (remainder * 2 == divider && number % 2 == 1)) {
+          number += 1;
+        }
+        break;
+      case 2:
+        if (!is_negative) {
+          number += 1;
+        }
+        break;
+      case 3:
+        if (is_negative) {
+          number += 1;
+        }
+        break;
+    }
+  }
+}
+
+constexpr void FloatingPointArithmetic::FixFormat() {
+  if (format == 'h') {
+    mantissa_size = 10;
+    exponent_size = 5;
+    exponent_shift = 15;
+    max_exponent = 16;
+    min_exponent = -15;
+  }
+}
+
+constexpr void FloatingPointArithmetic::Normalize(FloatingNumber &result,
+                                                  UnroundedNumber number) {
+  const bool is_negative = number.is_negative;
+  result.is_negative = is_negative;
+  if (number.mantissa == 0) {
+    result.MakeNull();
+    result.ChangeSign(rounding_type == 3);
+    return;
+  }
+  uint64_t mantissa = number.mantissa;
+  int32_t exponent = number.exponent;
+  uint64_t divider = number.divider;
+  int32_t point_shift = std::bit_width(mantissa) - 1;
+  if (point_shift < mantissa_size) {
+    exponent -= mantissa_size - point_shift;
+    mantissa <<= mantissa_size - point_shift;
+    point_shift = mantissa_size;
+  }
+  exponent += point_shift;
+  if (exponent >= max_exponent) {
+    result.FixOverflow();
+    return;
+  }
+  if (exponent < (min_exponent - mantissa_size + 1)) {
+    if (mantissa % ((uint64_t)1 << point_shift) == 0) {
+      result.mantissa = 0;
+    } else {
+      result.mantissa = 1;
+    }
+    result.exponent = exponent;
+    result.FixUnderflow();
+    return;
+  }
+  uint32_t denormal_digits = 0;
+  if (exponent <= min_exponent) {
+    denormal_digits = min_exponent - exponent + 1;
+  }
+  divider *= ((uint64_t)1 << (point_shift - mantissa_size + denormal_digits));
+  if (number.mantissa1 != 0) {
+    mantissa = number.mantissa1;
+  }
+  Round(mantissa, divider, is_negative);
+  if (mantissa >= ((uint64_t)1 << (mantissa_size - denormal_digits + 1))) {
+    exponent += 1;
+    if (exponent >= max_exponent) {
+      result.FixOverflow();
+      return;
+    }
+    mantissa >>= 1;
+  }
+  mantissa <<= denormal_digits;
+  mantissa %= (1 << mantissa_size);
+  result.type = kNormal;
+  result.mantissa = mantissa;
+  result.exponent = exponent;
+}
+
+constexpr void FloatingPointArithmetic::NormalizeBounds(
+    const UnroundedNumber &number, FloatingNumber &lower,
+    FloatingNumber &upper) {
+  uint8_t rounding = rounding_type;
+  rounding_type = 3;
+  Normalize(lower, number);
+  rounding_type = 2;
+  Normalize(upper, number);
+  rounding_type = rounding;
+}
+
+constexpr void FloatingPointArithmetic::Addition(UnroundedNumber &unrounded) {
+  uint64_t mantissa1 = number1.GetMantissa();
+  uint64_t mantissa2 = number2.GetMantissa();
+  int32_t exponent1 = number1.exponent;
+  int32_t exponent2 = number2.exponent;
+  bool is_negative1 = number1.is_negative;
+  bool is_negative2 = number2.is_negative;
+  if (exponent2 > exponent1) {
+    std::swap(exponent1, exponent2);
+    std::swap(mantissa1, mantissa2);
+    std::swap(is_negative1, is_negative2);
+  }
+  if ((exponent1 - exponent2) > (mantissa_size + 2)) {
+    // the second number is less than a quarter of the last digit of the
+    // first one, an eighth of it rounds the same way in every mode
+    unrounded.is_negative = is_negative1;
+    unrounded.exponent = exponent1 - mantissa_size - 3;
+    if ((is_negative1 ^ is_negative2) == 0) {
+      unrounded.mantissa = (mantissa1 << 3) + 1;
+    } else {
+      unrounded.mantissa = (mantissa1 << 3) - 1;
+    }
+    return;
+  }
+  mantissa1 <<= exponent1 - exponent2;
+  unrounded.exponent = exponent2 - mantissa_size;
+  // equal numbers of opposite signs give zero mantissa, the sign of zero
+  // is chosen by Normalize
+  if ((is_negative1 ^ is_negative2) == 0) {
+    unrounded.is_negative = is_negative1;
+    unrounded.mantissa = mantissa1 + mantissa2;
+  } else if (mantissa1 > mantissa2) {
+    unrounded.is_negative = is_negative1;
+    unrounded.mantissa = mantissa1 - mantissa2;
+  } else {
+    unrounded.is_negative = is_negative2;
+    unrounded.mantissa = mantissa2 - mantissa1;
+  }
+}
+
+constexpr void FloatingPointArithmetic::Multiplication(
+    UnroundedNumber &unrounded) {
+  uint64_t mantissa1 = number1.GetMantissa();
+  uint64_t mantissa2 = number2.GetMantissa();
+  unrounded.exponent = number1.exponent + number2.exponent - 2 * mantissa_size;
+  unrounded.mantissa = mantissa1 * mantissa2;
+  unrounded.is_negative = number1.IsNegative() ^ number2.IsNegative();
+}
+
+constexpr void FloatingPointArithmetic::Division(UnroundedNumber &unrounded) {
+  uint64_t mantissa1 = number1.GetMantissa();
+  uint64_t mantissa2 = number2.GetMantissa();
+  unrounded.exponent = number1.exponent - number2.exponent - mantissa_size - 1;
+  unrounded.mantissa = (mantissa1 << (mantissa_size + 1)) / mantissa2;
+  unrounded.is_negative = number1.IsNegative() ^ number2.IsNegative();
+  unrounded.mantissa1 = mantissa1 << (mantissa_size + 1);
+  unrounded.divider = mantissa2;
+}
+
+constexpr bool FloatingPointArithmetic::SpecialAddition(
+    FloatingNumber &result, UnroundedNumber &unrounded) {
+  if (number1.IsInfinity() && number2.IsInfinity() &&
+      (number1.IsNegative() ^ number2.IsNegative()) == 1) {
+    result.MakeNan();
+    return false;
+  }
+  if (number1.IsInfinity()) {
+    result.MakeInfinity();
+    result.ChangeSign(number1.is_negative);
+    return false;
+  }
+  if (number2.IsInfinity()) {
+    result.MakeInfinity();
+    result.ChangeSign(number2.is_negative);
+    return false;
+  }
+  if (number1.IsNull() && number2.IsNull() &&
+      (number1.IsNegative() ^ number2.IsNegative()) == 1) {
+    // zero mantissa, the sign of zero depends on the rounding
+    unrounded.mantissa = 0;
+    return true;
+  }
+  if (number1.IsNull()) {
+    result = number2;
+    return false;
+  }
+  result = number1;
+  return false;
+}
+
+constexpr void FloatingPointArithmetic::SpecialMultiplication(
+    FloatingNumber &result) {
+  if ((number1.IsNull() && number2.IsInfinity()) ||
+      (number2.IsNull() && number1.IsInfinity())) {
+    result.MakeNan();
+    return;
+  }
+  if (number1.IsInfinity() || number2.IsInfinity()) {
+    result.MakeInfinity();
+  } else {
+    result.MakeNull();
+  }
+  result.ChangeSign(number1.IsNegative() ^ number2.IsNegative());
+}
+
+constexpr void FloatingPointArithmetic::SpecialDivision(
+    FloatingNumber &result) {
+  if (number1.IsNull() && number2.IsNull()) {
+    result.MakeNan();
+    return;
+  }
+  if (number1.IsInfinity() && number2.IsInfinity()) {
+    result.MakeNan();
+    return;
+  }
+  if (number1.IsInfinity() || number2.IsNull()) {
+    result.MakeInfinity();
+  } else {
+    result.MakeNull();
+  }
+  result.ChangeSign(number1.IsNegative() ^ number2.IsNegative());
+}
+
+constexpr bool FloatingPointArithmetic::Evaluate(FloatingNumber &result,
+                                                 UnroundedNumber &unrounded) {
+  if (operation == '=') {
+    result = number1;
+    return false;
+  }
+  if (operation != '+' && operation != '-' && operation != '*' &&
+      operation != '/') {
+    result.MakeNan();
+    return false;
+  }
+  if (operation == '-') {
+    number2.ChangeSign(!number2.IsNegative());
+  }
+  if ((number1.type | number2.type) != kNormal) [[unlikely]] {
+    // nan, infinity or zero among the operands, the result is exact except
+    // for the sum of zeros of opposite signs
+    if ((number1.type | number2.type) & kNan) {
+      result.MakeNan();
+      return false;
+    }
+    switch (operation) {
+      case '*':
+        SpecialMultiplication(result);
+        return false;
+      case '/':
+        SpecialDivision(result);
+        return false;
+    }
+    return SpecialAddition(result, unrounded);
+  }
+  switch (operation) {
+    case '*':
+      Multiplication(unrounded);
+      break;
+    case '/':
+      Division(unrounded);
+      break;
+    default:
+      Addition(unrounded);
+      break;
+  }
+  return true;
+}
+
+constexpr FloatingPointArithmetic::FloatingPointArithmetic(
+    const uint8_t format, const uint8_t rounding_type)
+    : rounding_type(rounding_type),
+      number1(format, rounding_type),
+      number2(format, rounding_type),
+      format(format) {
+  FixFormat();
+}
+
+constexpr FloatingPointArithmetic::FloatingPointArithmetic() = default;
+
+constexpr FloatingNumber FloatingPointArithmetic::Calculate(
+    const FloatingNumber &first, const uint8_t operation,
+    const FloatingNumber &second) {
+  number1 = first;
+  number2 = second;
+  this->operation = operation;
+  FloatingNumber result(format, rounding_type);
+  UnroundedNumber unrounded;
+  if (Evaluate(result, unrounded)) {
+    Normalize(result, unrounded);
+  }
+  return result;
+}
+
+// The root of mantissa * 2^exponent is taken from the integer with at least
+// mantissa_size + 6 more bits and an even exponent, the remainder is kept
+// as the lowest (sticky) bit, so Normalize rounds it as the exact root
+constexpr FloatingNumber FloatingPointArithmetic::SquareRoot(
+    const FloatingNumber &number) {
+  FloatingNumber result(format, rounding_type);
+  if (number.IsNan() || (number.IsNegative() && !number.IsNull())) {
+    result.MakeNan();
+    return result;
+  }
+  if (number.type != kNormal) {
+    result = number;
+    return result;
+  }
+  int32_t exponent = number.exponent - mantissa_size;
+  int32_t shift = mantissa_size + 6;
+  if (((exponent - shift) & 1) != 0) {
+    ++shift;
+  }
+  uint64_t value = (uint64_t)number.GetMantissa() << shift;
+  uint64_t root = 0;
+  for (int32_t bit = (std::bit_width(value) - 1) / 2; bit >= 0; --bit) {
+    uint64_t candidate = root | ((uint64_t)1 << bit);
+    if (candidate * candidate <= value) {
+      root = candidate;
+    }
+  }
+  UnroundedNumber unrounded;
+  unrounded.mantissa = (root << 1) | (root * root != value);
+  unrounded.exponent = (exponent - shift) / 2 - 1;
+  Normalize(result, unrounded);
+  return result;
+}
+
+constexpr void FloatingPointArithmetic::CalculateBounds(
+    const FloatingNumber &first, const uint8_t operation,
+    const FloatingNumber &second, FloatingNumber &lower,
+    FloatingNumber &upper) {
+  number1 = first;
+  number2 = second;
+  this->operation = operation;
+  UnroundedNumber unrounded;
+  if (Evaluate(lower, unrounded)) {
+    NormalizeBounds(unrounded, lower, upper);
+  } else {
+    upper = lower;
+  }
+}
+
+constexpr FloatingInterval FloatingPointArithmetic::CalculateInterval(
+    const FloatingInterval &first, const uint8_t operation,
+    const FloatingInterval &second) {
+  FloatingInterval result{FloatingNumber(format, 3), FloatingNumber(format, 2)};
+  if (first.lower.IsNan() || first.upper.IsNan() || second.lower.IsNan() ||
+      second.upper.IsNan()) {
+    result.lower.MakeNan();
+    result.upper.MakeNan();
+    return result;
+  }
+  FloatingNumber zero(format, rounding_type);
+  zero.MakeNull();
+  if (operation == '/' && !second.upper.IsLess(zero) &&
+      !zero.IsLess(second.lower)) {
+    result.lower.MakeInfinity();
+    result.lower.ChangeSign(true);
+    result.upper.MakeInfinity();
+    return result;
+  }
+  bool is_point = !first.lower.IsLess(first.upper) &&
+                  !second.lower.IsLess(second.upper);
+  if ((operation == '+' || operation == '-') && !is_point) {
+    // the lower end is the sum of the lower ends (with the upper end of the
+    // subtrahend), it is only rounded down, the upper one only up
+    const FloatingNumber &lower2 =
+        (operation == '+') ? second.lower : second.upper;
+    const FloatingNumber &upper2 =
+        (operation == '+') ? second.upper : second.lower;
+    uint8_t rounding = rounding_type;
+    rounding_type = 3;
+    result.lower = Calculate(first.lower, operation, lower2);
+    rounding_type = 2;
+    result.upper = Calculate(first.upper, operation, upper2);
+    rounding_type = rounding;
+    if (!result.lower.IsNan() && !result.upper.IsNan()) {
+      return result;
+    }
+    // infinities of opposite signs at one pair, the bounds are given by the
+    // other one below
+    result.lower = FloatingNumber(format, 3);
+    result.upper = FloatingNumber(format, 2);
+  }
+  // the bounds are reached at the ends of the operands, every end pair is
+  // evaluated once and rounded both down and up
+  const FloatingNumber *ends1[2] = {&first.lower, &first.upper};
+  const FloatingNumber *ends2[2] = {&second.lower, &second.upper};
+  bool is_done[2][2] = {};
+  bool is_empty = true;
+  for (int32_t i = 0; i < 2; ++i) {
+    for (int32_t j = 0; j < 2; ++j) {
+      if ((operation == '+' && i != j) || (operation == '-' && i == j)) {
+        continue;
+      }
+      int32_t k = first.lower.IsLess(first.upper) ? i : 0;
+      int32_t l = second.lower.IsLess(second.upper) ? j : 0;
+      if (is_done[k][l]) {
+        continue;
+      }
+      is_done[k][l] = true;
+      FloatingNumber lower(format, 3);
+      FloatingNumber upper(format, 2);
+      CalculateBounds(*ends1[k], operation, *ends2[l], lower, upper);
+      if (lower.IsNan()) {
+        // zero by infinity at the ends, the limit inside the interval is
+        // given by the other pairs
+        continue;
+      }
+      if (is_empty || lower.IsLess(result.lower)) {
+        result.lower = lower;
+      }
+      if (is_empty || result.upper.IsLess(upper)) {
+        result.upper = upper;
+      }
+      is_empty = false;
+    }
+  }
+  if (is_empty) {
+    result.lower.MakeNan();
+    result.upper.MakeNan();
+  }
+  return result;
+}
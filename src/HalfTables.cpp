@@ -0,0 +1,77 @@
+#include "HalfTables.h"
+
+HalfTables::HalfTables(const uint8_t rounding_type)
+    : rounding_type(rounding_type),
+      decoded(kSize),
+      widened(kSize),
+      roots(kSize),
+      reciprocals(kSize),
+      negations(kSize) {
+  FloatingPointArithmetic arithmetic('h', rounding_type);
+  FloatingNumber one(0x3c00, 'h', rounding_type);
+  for (uint32_t i = 0; i < kSize; ++i) {
+    FloatingNumber number(i, 'h', rounding_type);
+    decoded[i] = {number.is_negative, number.type, (uint16_t)number.mantissa,
+                  (int16_t)number.exponent};
+    // every half is a normal float with the same exponent, nan keeps its
+    // payload
+    FloatingNumber wide('f', rounding_type);
+    wide.is_negative = number.is_negative;
+    wide.type = number.type;
+    wide.exponent = number.exponent;
+    wide.mantissa = number.mantissa << (wide.mantissa_size - 10);
+    if (number.IsInfinity() || number.IsNan()) {
+      wide.exponent = wide.max_exponent;
+    } else if (number.IsNull()) {
+      wide.exponent = wide.min_exponent;
+    }
+    widened[i] = wide.Encode();
+    roots[i] = arithmetic.SquareRoot(number).Encode();
+    reciprocals[i] = arithmetic.Calculate(one, '/', number).Encode();
+    negations[i] = i ^ 0x8000;
+  }
+}
+
+void HalfTables::Decode(const uint16_t *numbers, const size_t size,
+                        FloatingNumber *results) const {
+  FloatingNumber number('h', rounding_type);
+  for (size_t i = 0; i < size; ++i) {
+    const HalfDecoded &entry = decoded[numbers[i]];
+    number.is_negative = entry.is_negative;
+    number.type = entry.type;
+    number.mantissa = entry.mantissa;
+    number.exponent = entry.exponent;
+    results[i] = number;
+  }
+}
+
+void HalfTables::Widen(const uint16_t *numbers, const size_t size,
+                       uint32_t *results) const {
+  for (size_t i = 0; i < size; ++i) {
+    results[i] = widened[numbers[i]];
+  }
+}
+
+// Square root ('s'), reciprocal ('r') or negation ('n') of every number,
+// returns false for other operations
+bool HalfTables::Calculate(const uint8_t operation, const uint16_t *numbers,
+                           const size_t size, uint16_t *results) const {
+  const uint16_t *table;
+  switch (operation) {
+    case 's':
+      table = roots.data();
+      break;
+    case 'r':
+      table = reciprocals.data();
+      break;
+    case 'n':
+      table = negations.data();
+      break;
+    default:
+      return false;
+  }
+  for (size_t i = 0; i < size; ++i) {
+    results[i] = table[numbers[i]];
+  }
+  return true;
+}
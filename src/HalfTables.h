@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "FloatingPoint.h"
+
+// Decoded 'h' number without the format constants of FloatingNumber
+struct HalfDecoded {
+  bool is_negative = false;
+  uint8_t type = kNormal;
+  uint16_t mantissa = 0;
+  int16_t exponent = 0;
+};
+
+// Tables over all 65536 'h' encodings: the decoded form, the exact binary32
+// widening and the results of square root, reciprocal and negation with the
+// given rounding. They are built once by the constructor, after that every
+// batch call is a single table read per element.
+class HalfTables {
+  static constexpr size_t kSize = 65536;
+
+  uint8_t rounding_type = 0;
+
+  std::vector<HalfDecoded> decoded;
+  std::vector<uint32_t> widened;
+  std::vector<uint16_t> roots;
+  std::vector<uint16_t> reciprocals;
+  std::vector<uint16_t> negations;
+
+ public:
+  HalfTables(const uint8_t rounding_type);
+
+  void Decode(const uint16_t *numbers, const size_t size,
+              FloatingNumber *results) const;
+
+  void Widen(const uint16_t *numbers, const size_t size,
+             uint32_t *results) const;
+
+  bool Calculate(const uint8_t operation, const uint16_t *numbers,
+                 const size_t size, uint16_t *results) const;
+};
@@ -0,0 +1,26 @@
+#include "HexNumber.h"
+
+bool ReadHex(const char *&arg, uint64_t &number) {
+  if (arg[0] != '0' || arg[1] != 'x') {
+    return false;
+  }
+  arg += 2;
+  number = 0;
+  while (isxdigit(*arg)) {
+    int digit;
+    if (isdigit(*arg)) {
+      digit = *arg - 48;
+    } else if (*arg > 64 && *arg < 71) {
+      digit = *arg - 55;
+    } else {
+      digit = *arg - 87;
+    }
+    number = number * 16 + digit;
+    ++arg;
+  }
+  return true;
+}
+
+bool HexToInt(const char *arg, uint64_t &number) {
+  return ReadHex(arg, number) && *arg == '\0';
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <cctype>
+#include <cstdint>
+
+// Reads "0x" and the hex digits after it, arg is left after the last digit.
+// Only the last 16 digits are kept, callers cut the number to their format.
+bool ReadHex(const char *&arg, uint64_t &number);
+
+// Same for a whole argument, returns false if anything follows the digits
+bool HexToInt(const char *arg, uint64_t &number);
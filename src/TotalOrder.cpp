@@ -0,0 +1,183 @@
+#include "TotalOrder.h"
+
+TotalOrder::TotalOrder(const uint8_t format) {
+  if (format == 'h') {
+    number_size = 16;
+  } else if (format != 'f') {
+    number_size = 0;
+  }
+}
+
+// The sizes are checked like in FixedPointArithmetic::Parse, the width must
+// be in [1, 64]
+TotalOrder::TotalOrder(const uint8_t integer_size,
+                       const uint8_t fractional_size)
+    : is_floating(false), number_size(integer_size + fractional_size) {
+  if (number_size > 64) {
+    number_size = 0;
+  }
+}
+
+bool TotalOrder::IsValid() const { return number_size != 0; }
+
+bool TotalOrder::Fits(const size_t element_size) const {
+  return IsValid() && number_size <= 8 * (int32_t)element_size;
+}
+
+// Keys of an invalid order are 0
+uint64_t TotalOrder::GetKey(uint64_t number) const {
+  if (!IsValid()) {
+    return 0;
+  }
+  uint64_t mask = ~uint64_t(0) >> (64 - number_size);
+  uint64_t sign = uint64_t(1) << (number_size - 1);
+  number &= mask;
+  if (!is_floating) {
+    return number ^ sign;
+  }
+  // negative numbers are ordered backwards by module
+  if ((number & sign) != 0) {
+    return ~number & mask;
+  }
+  return number | sign;
+}
+
+uint64_t TotalOrder::FromKey(const uint64_t key) const {
+  if (!IsValid()) {
+    return 0;
+  }
+  uint64_t mask = ~uint64_t(0) >> (64 - number_size);
+  uint64_t sign = uint64_t(1) << (number_size - 1);
+  if (!is_floating) {
+    return key ^ sign;
+  }
+  if ((key & sign) != 0) {
+    return key & ~sign;
+  }
+  return ~key & mask;
+}
+
+// LSD radix sort by bytes of the keys, passes where all keys share the byte
+// are skipped. Returns false if the numbers are wider than the elements.
+template <typename Number>
+bool TotalOrder::Sort(Number *numbers, const size_t size) const {
+  if (!Fits(sizeof(Number))) {
+    return false;
+  }
+  const int32_t passes = (number_size + 7) / 8;
+  size_t counts[8][256] = {};
+  for (size_t i = 0; i < size; ++i) {
+    uint64_t key = GetKey(numbers[i]);
+    for (int32_t pass = 0; pass < passes; ++pass) {
+      ++counts[pass][(key >> (8 * pass)) & 255];
+    }
+  }
+  std::vector<Number> buffer(size);
+  Number *from = numbers;
+  Number *to = buffer.data();
+  for (int32_t pass = 0; pass < passes; ++pass) {
+    int32_t shift = 8 * pass;
+    if (size == 0 || counts[pass][(GetKey(from[0]) >> shift) & 255] == size) {
+      continue;
+    }
+    size_t offsets[256];
+    size_t offset = 0;
+    for (int32_t digit = 0; digit < 256; ++digit) {
+      offsets[digit] = offset;
+      offset += counts[pass][digit];
+    }
+    for (size_t i = 0; i < size; ++i) {
+      to[offsets[(GetKey(from[i]) >> shift) & 255]++] = from[i];
+    }
+    std::swap(from, to);
+  }
+  if (from != numbers) {
+    memcpy(numbers, from, size * sizeof(Number));
+  }
+  return true;
+}
+
+// Counts of numbers by the first bucket_bits bits of their keys, returns
+// false if bucket_bits is not in [0, min(number_size, 24)], the counts take
+// 8 << bucket_bits bytes
+template <typename Number>
+bool TotalOrder::Histogram(const Number *numbers, const size_t size,
+                           const int32_t bucket_bits,
+                           std::vector<size_t> &counts) const {
+  if (!Fits(sizeof(Number)) || bucket_bits < 0 ||
+      bucket_bits > number_size || bucket_bits > kMaxBucketBits) {
+    return false;
+  }
+  counts.assign((size_t)1 << bucket_bits, 0);
+  int32_t shift = number_size - bucket_bits;
+  for (size_t i = 0; i < size; ++i) {
+    // a shift by all 64 bits leaves the only bucket
+    uint64_t key = GetKey(numbers[i]);
+    ++counts[(shift < 64) ? key >> shift : 0];
+  }
+  return true;
+}
+
+// Number with the given rank (0 for the least) in total order, found by
+// histograms of the key bytes from the highest one, without sorting.
+// Returns false if there is no such number (rank >= size).
+template <typename Number>
+bool TotalOrder::Select(const Number *numbers, const size_t size,
+                        size_t rank, Number &result) const {
+  if (!Fits(sizeof(Number)) || rank >= size) {
+    return false;
+  }
+  uint64_t prefix = 0;
+  for (int32_t shift = (number_size + 7) / 8 * 8 - 8; shift >= 0;
+       shift -= 8) {
+    // bits above the current byte, none for the highest byte of 64 bits
+    uint64_t high = (shift + 8 < 64) ? ~uint64_t(0) << (shift + 8) : 0;
+    size_t counts[256] = {};
+    for (size_t i = 0; i < size; ++i) {
+      uint64_t key = GetKey(numbers[i]);
+      if (((key ^ prefix) & high) == 0) {
+        ++counts[(key >> shift) & 255];
+      }
+    }
+    uint64_t digit = 0;
+    while (digit < 255 && rank >= counts[digit]) {
+      rank -= counts[digit];
+      ++digit;
+    }
+    prefix |= digit << shift;
+  }
+  result = FromKey(prefix);
+  return true;
+}
+
+// Lower nearest rank quantile, returns false for an empty array or a
+// fraction outside [0, 1]
+template <typename Number>
+bool TotalOrder::Quantile(const Number *numbers, const size_t size,
+                          const double fraction, Number &result) const {
+  if (size == 0 || !(fraction >= 0 && fraction <= 1)) {
+    return false;
+  }
+  size_t rank = fraction * (size - 1);
+  if (rank >= size) {
+    rank = size - 1;
+  }
+  return Select(numbers, size, rank, result);
+}
+
+template bool TotalOrder::Sort(uint32_t *, const size_t) const;
+template bool TotalOrder::Sort(uint64_t *, const size_t) const;
+template bool TotalOrder::Histogram(const uint32_t *, const size_t,
+                                    const int32_t,
+                                    std::vector<size_t> &) const;
+template bool TotalOrder::Histogram(const uint64_t *, const size_t,
+                                    const int32_t,
+                                    std::vector<size_t> &) const;
+template bool TotalOrder::Select(const uint32_t *, const size_t, size_t,
+                                 uint32_t &) const;
+template bool TotalOrder::Select(const uint64_t *, const size_t, size_t,
+                                 uint64_t &) const;
+template bool TotalOrder::Quantile(const uint32_t *, const size_t,
+                                   const double, uint32_t &) const;
+template bool TotalOrder::Quantile(const uint64_t *, const size_t,
+                                   const double, uint64_t &) const;
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// Maps encodings of 'h'/'f' numbers (sign and module) and A.B fixed point
+// numbers of up to 64 bits (two's complement) to unsigned keys in IEEE total
+// order: -nan < -inf < ... < -0 < +0 < ... < +inf < +nan. Keys are compared
+// as plain integers, so arrays are sorted and bucketed without decoding.
+class TotalOrder {
+  static constexpr int32_t kMaxBucketBits = 24;
+
+  bool is_floating = true;
+  int32_t number_size = 32;
+
+  bool Fits(const size_t element_size) const;
+
+ public:
+  TotalOrder(const uint8_t format);
+
+  TotalOrder(const uint8_t integer_size, const uint8_t fractional_size);
+
+  // False for a format other than 'h'/'f' or a width of A.B not in [1, 64],
+  // every function of an invalid order fails
+  bool IsValid() const;
+
+  uint64_t GetKey(uint64_t number) const;
+
+  uint64_t FromKey(const uint64_t key) const;
+
+  // Arrays hold uint32_t ('h', 'f' and A.B up to 32 bits) or uint64_t
+  // numbers, functions return false if the numbers do not fit the type
+  template <typename Number>
+  bool Sort(Number *numbers, const size_t size) const;
+
+  template <typename Number>
+  bool Histogram(const Number *numbers, const size_t size,
+                 const int32_t bucket_bits, std::vector<size_t> &counts) const;
+
+  template <typename Number>
+  bool Select(const Number *numbers, const size_t size, size_t rank,
+              Number &result) const;
+
+  template <typename Number>
+  bool Quantile(const Number *numbers, const size_t size,
+                const double fraction, Number &result) const;
+};
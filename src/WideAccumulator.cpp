@@ -0,0 +1,128 @@
+#include "WideAccumulator.h"
+
+WideAccumulator::WideAccumulator(const int32_t lowest_exponent)
+    : lowest_exponent(lowest_exponent) {}
+
+WideAccumulator::WideAccumulator() = default;
+
+void WideAccumulator::Add(uint64_t mantissa, const int32_t exponent,
+                          const bool is_negative) {
+  int32_t position = exponent - lowest_exponent;
+  int32_t word = position / 64;
+  int32_t shift = position % 64;
+  uint64_t parts[2] = {mantissa << shift, 0};
+  if (shift != 0) {
+    parts[1] = mantissa >> (64 - shift);
+  }
+  if (!is_negative) {
+    uint64_t carry = 0;
+    for (int32_t i = word; i < kWords; ++i) {
+      uint64_t part = (i - word < 2) ? parts[i - word] : 0;
+      uint64_t sum = words[i] + part;
+      uint64_t next_carry = (sum < part);
+      words[i] = sum + carry;
+      next_carry |= (words[i] < carry);
+      carry = next_carry;
+      if (carry == 0 && i - word >= 1) {
+        break;
+      }
+    }
+    return;
+  }
+  uint64_t borrow = 0;
+  for (int32_t i = word; i < kWords; ++i) {
+    uint64_t part = (i - word < 2) ? parts[i - word] : 0;
+    uint64_t difference = words[i] - part;
+    uint64_t next_borrow = (words[i] < part);
+    next_borrow |= (difference < borrow);
+    words[i] = difference - borrow;
+    borrow = next_borrow;
+    if (borrow == 0 && i - word >= 1) {
+      break;
+    }
+  }
+}
+
+void WideAccumulator::Negate() {
+  uint64_t carry = 1;
+  for (int32_t i = 0; i < kWords; ++i) {
+    words[i] = ~words[i] + carry;
+    carry = (carry != 0 && words[i] == 0);
+  }
+}
+
+void WideAccumulator::Merge(const WideAccumulator &other) {
+  uint64_t carry = 0;
+  for (int32_t i = 0; i < kWords; ++i) {
+    uint64_t sum = words[i] + other.words[i];
+    uint64_t next_carry = (sum < other.words[i]);
+    words[i] = sum + carry;
+    next_carry |= (words[i] < carry);
+    carry = next_carry;
+  }
+  is_nan |= other.is_nan;
+  is_positive_infinity |= other.is_positive_infinity;
+  is_negative_infinity |= other.is_negative_infinity;
+  has_positive |= other.has_positive;
+  has_negative |= other.has_negative;
+}
+
+// Divides the module of the sum by divider word by word from the highest
+// one. A nonzero remainder is ORed into the lowest bit, which is far below
+// the last bit of any result, so the quotient is rounded as the exact one.
+void WideAccumulator::Divide(const uint64_t divider) {
+  bool is_negative = (words[kWords - 1] >> 63) != 0;
+  if (is_negative) {
+    Negate();
+  }
+  unsigned __int128 remainder = 0;
+  for (int32_t i = kWords - 1; i >= 0; --i) {
+    unsigned __int128 dividend = (remainder << 64) | words[i];
+    words[i] = dividend / divider;
+    remainder = dividend % divider;
+  }
+  words[0] |= (remainder != 0);
+  if (is_negative) {
+    Negate();
+  }
+}
+
+// Module of the sum as a 63 bit mantissa with the first bit set. Bits which
+// do not fit are ORed into the lowest one (rounding to odd), so rounding the
+// mantissa later to at most 60 bits gives the same result as rounding the
+// exact sum. Returns false for zero.
+bool WideAccumulator::GetModule(uint64_t &mantissa, int32_t &exponent,
+                                bool &is_negative) const {
+  WideAccumulator copy = *this;
+  is_negative = (words[kWords - 1] >> 63) != 0;
+  if (is_negative) {
+    copy.Negate();
+  }
+  const uint64_t *module = copy.words;
+  int32_t word = kWords - 1;
+  while (word >= 0 && module[word] == 0) {
+    --word;
+  }
+  if (word < 0) {
+    return false;
+  }
+  int32_t top = word * 64 + std::bit_width(module[word]) - 1;
+  int32_t shift = top - 62;
+  exponent = lowest_exponent + shift;
+  if (shift <= 0) {
+    mantissa = module[0] << -shift;
+    return true;
+  }
+  int32_t low_word = shift / 64;
+  int32_t low_shift = shift % 64;
+  mantissa = module[low_word] >> low_shift;
+  if (low_shift != 0 && low_word + 1 < kWords) {
+    mantissa |= module[low_word + 1] << (64 - low_shift);
+  }
+  bool is_sticky = (module[low_word] & (((uint64_t)1 << low_shift) - 1)) != 0;
+  for (int32_t i = 0; i < low_word; ++i) {
+    is_sticky |= (module[i] != 0);
+  }
+  mantissa |= is_sticky;
+  return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+
+// Exact sum of numbers mantissa * 2^exponent kept as a two's complement
+// integer of kWords * 64 bits, the lowest bit is 2^lowest_exponent. Integer
+// addition is associative, so partial sums can be merged in any order.
+struct WideAccumulator {
+  static constexpr int32_t kWords = 12;
+
+  uint64_t words[kWords] = {};
+  int32_t lowest_exponent = 0;
+
+  bool is_nan = false;
+  bool is_positive_infinity = false;
+  bool is_negative_infinity = false;
+  bool has_positive = false;
+  bool has_negative = false;
+
+  WideAccumulator(const int32_t lowest_exponent);
+
+  WideAccumulator();
+
+  void Add(uint64_t mantissa, const int32_t exponent, const bool is_negative);
+
+  void Negate();
+
+  void Merge(const WideAccumulator &other);
+
+  void Divide(const uint64_t divider);
+
+  bool GetModule(uint64_t &mantissa, int32_t &exponent,
+                 bool &is_negative) const;
+};